@@ -13,7 +13,23 @@
 #include <queue>
 #include <functional>
 #include <unordered_set>
+#include <unordered_map>
 #include <iomanip>
+#include <string_view>
+#include <optional>
+#include <map>
+#include <set>
+#include <array>
+#include <charconv>
+#include <type_traits>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <atomic>
 #include <curl/curl.h>
 #include <nlohmann/json.hpp>
 
@@ -35,55 +51,797 @@ struct Carta {
         : id(i), nome(n), jogo(j), poder(p), resistencia(r), tipos(t), rating(rt) {}
 };
 
+// Políticas de chave: Tipo é o que a tabela hash e a AVL comparam, converter
+// extrai a chave do ID textual (nullopt se o ID não for compatível). Propria é
+// a forma guardada no modo em camadas, em que a carta com o ID pode ser despejada.
+struct ChaveTexto {
+    // Aponta para Carta::id; válido enquanto a carta estiver na coleção.
+    using Tipo = string_view;
+    using Propria = string;
+    static optional<Tipo> converter(string_view id) { return id; }
+};
+
+struct ChaveInteira {
+    using Tipo = uint64_t;
+    using Propria = uint64_t;
+    static optional<Tipo> converter(string_view id) {
+        Tipo valor = 0;
+        auto [fim, erro] = from_chars(id.data(), id.data() + id.size(), valor);
+        if (id.empty() || erro != errc() || fim != id.data() + id.size()) return nullopt;
+        return valor;
+    }
+};
+
+struct HashPolinomial {
+    size_t operator()(string_view id) const {
+        size_t h = 0;
+        for (char c : id) {
+            h = h * 31 + c;
+        }
+        return h;
+    }
+};
+
+struct HashFNV1a {
+    size_t operator()(string_view id) const {
+        uint64_t h = 1469598103934665603ULL;
+        for (char c : id) {
+            h ^= static_cast<unsigned char>(c);
+            h *= 1099511628211ULL;
+        }
+        return h;
+    }
+};
+
+struct HashInteiro {
+    size_t operator()(uint64_t x) const {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        x ^= x >> 33;
+        return x;
+    }
+};
+
+// Conjunto de índices mantidos além da tabela hash. Índices desligados não geram
+// código e não alocam nada; o membro correspondente vira um tipo vazio (1 byte).
+template <bool Ordenado, bool PorRating, bool Agregados = false, bool Camadas = false>
+struct IndicesCartas {
+    static constexpr bool ordenado = Ordenado;
+    static constexpr bool porRating = PorRating;
+    static constexpr bool agregados = Agregados;
+    static constexpr bool camadas = Camadas;
+};
+
+using SomenteHash = IndicesCartas<false, false>;
+using HashOrdenado = IndicesCartas<true, false>;
+using HashOrdenadoRating = IndicesCartas<true, true>;
+
+// Acrescenta AgregadosCartas a um conjunto de índices. As estatísticas ficam
+// instantâneas, mas cada inserção e remoção passa a atualizar três multisets e
+// o mapa por tipo.
+template <class I>
+using ComAgregados = IndicesCartas<I::ordenado, I::porRating, true, I::camadas>;
+
+// Permite definirOrcamentoMemoria. Cada entrada passa a guardar a chave própria,
+// o rating e a posição no arquivo de páginas, mesmo sem orçamento definido.
+template <class I>
+using ComCamadas = IndicesCartas<I::ordenado, I::porRating, I::agregados, true>;
+
+// Estatísticas mantidas a cada inserção e remoção, consultadas sem percorrer a coleção.
+struct AgregadosCartas {
+    static constexpr int FAIXAS_RATING = 10;
+
+    int total = 0;
+    long long somaPoder = 0;
+    long long somaResistencia = 0;
+    double somaRating = 0;
+    multiset<int> poderes;
+    multiset<int> resistencias;
+    multiset<float> ratings;
+    array<int, FAIXAS_RATING> histogramaRating{};
+    map<string, int> porTipo;
+
+    static int faixaRating(float rating) {
+        return clamp(static_cast<int>(rating), 0, FAIXAS_RATING - 1);
+    }
+
+    void adicionar(const Carta& c) {
+        total++;
+        somaPoder += c.poder;
+        somaResistencia += c.resistencia;
+        somaRating += c.rating;
+        poderes.insert(c.poder);
+        resistencias.insert(c.resistencia);
+        ratings.insert(c.rating);
+        histogramaRating[faixaRating(c.rating)]++;
+        for (const auto& tipo : c.tipos) {
+            porTipo[tipo]++;
+        }
+    }
+
+    void remover(const Carta& c) {
+        total--;
+        somaPoder -= c.poder;
+        somaResistencia -= c.resistencia;
+        somaRating -= c.rating;
+        removerValor(poderes, c.poder);
+        removerValor(resistencias, c.resistencia);
+        removerValor(ratings, c.rating);
+        histogramaRating[faixaRating(c.rating)]--;
+        for (const auto& tipo : c.tipos) {
+            auto it = porTipo.find(tipo);
+            if (it != porTipo.end() && --it->second == 0) porTipo.erase(it);
+        }
+    }
+
+    void limpar() {
+        *this = AgregadosCartas();
+    }
+
+    template <class T>
+    static void removerValor(multiset<T>& valores, const T& valor) {
+        auto it = valores.find(valor);
+        if (it != valores.end()) valores.erase(it);
+    }
+
+    double mediaPoder() const { return total ? static_cast<double>(somaPoder) / total : 0; }
+    double mediaResistencia() const { return total ? static_cast<double>(somaResistencia) / total : 0; }
+    double mediaRating() const { return total ? somaRating / total : 0; }
+};
+
+// Pool com uma fila por thread: cada thread consome o fim da própria fila e,
+// quando ela esvazia, rouba do início das filas das outras.
+class PoolTrabalho {
+public:
+    explicit PoolTrabalho(unsigned quantidade = max(1u, thread::hardware_concurrency())) {
+        for (unsigned i = 0; i < quantidade; i++) {
+            filas.push_back(make_unique<Fila>());
+        }
+        for (unsigned i = 0; i < quantidade; i++) {
+            threads.emplace_back([this, i] { executar(i); });
+        }
+    }
+
+    ~PoolTrabalho() {
+        {
+            lock_guard<mutex> trava(mutexEspera);
+            parar = true;
+        }
+        cvEspera.notify_all();
+        for (auto& t : threads) t.join();
+    }
+
+    PoolTrabalho(const PoolTrabalho&) = delete;
+    PoolTrabalho& operator=(const PoolTrabalho&) = delete;
+
+    size_t quantidadeThreads() const {
+        return threads.size();
+    }
+
+    template <class F>
+    auto submeter(F f) -> future<invoke_result_t<F>> {
+        using R = invoke_result_t<F>;
+        auto tarefa = make_shared<packaged_task<R()>>(move(f));
+        future<R> resultado = tarefa->get_future();
+
+        size_t indice = donoAtual == this ? filaAtual : proxima++ % filas.size();
+        {
+            lock_guard<mutex> trava(filas[indice]->m);
+            filas[indice]->tarefas.push_back([tarefa] { (*tarefa)(); });
+        }
+        {
+            lock_guard<mutex> trava(mutexEspera);
+            pendentes++;
+        }
+        cvEspera.notify_one();
+        return resultado;
+    }
+
+    // Espera o resultado executando tarefas pendentes, para que uma tarefa que
+    // aguarda suas subtarefas não bloqueie uma thread do pool. Sem tarefas para
+    // pegar, dorme no futuro por um intervalo curto em vez de girar.
+    template <class T>
+    T aguardar(future<T>& f) {
+        while (f.wait_for(chrono::seconds(0)) != future_status::ready) {
+            function<void()> tarefa;
+            if (retirar(donoAtual == this ? filaAtual : SEM_FILA, tarefa)) {
+                tarefa();
+            } else {
+                f.wait_for(ESPERA_SEM_TAREFA);
+            }
+        }
+        return f.get();
+    }
+
+private:
+    struct Fila {
+        mutex m;
+        deque<function<void()>> tarefas;
+    };
+
+    static constexpr size_t SEM_FILA = static_cast<size_t>(-1);
+    static constexpr chrono::microseconds ESPERA_SEM_TAREFA{200};
+
+    vector<unique_ptr<Fila>> filas;
+    vector<thread> threads;
+    mutex mutexEspera;
+    condition_variable cvEspera;
+    int pendentes = 0;
+    bool parar = false;
+    atomic<size_t> proxima{0};
+
+    inline static thread_local const PoolTrabalho* donoAtual = nullptr;
+    inline static thread_local size_t filaAtual = SEM_FILA;
+
+    bool retirar(size_t origem, function<void()>& tarefa) {
+        if (origem != SEM_FILA) {
+            lock_guard<mutex> trava(filas[origem]->m);
+            if (!filas[origem]->tarefas.empty()) {
+                tarefa = move(filas[origem]->tarefas.back());
+                filas[origem]->tarefas.pop_back();
+            }
+        }
+        for (size_t i = 0; !tarefa && i < filas.size(); i++) {
+            if (i == origem) continue;
+            lock_guard<mutex> trava(filas[i]->m);
+            if (!filas[i]->tarefas.empty()) {
+                tarefa = move(filas[i]->tarefas.front());
+                filas[i]->tarefas.pop_front();
+            }
+        }
+        if (!tarefa) return false;
+
+        lock_guard<mutex> trava(mutexEspera);
+        pendentes--;
+        return true;
+    }
+
+    void executar(size_t indice) {
+        donoAtual = this;
+        filaAtual = indice;
+        while (true) {
+            function<void()> tarefa;
+            if (retirar(indice, tarefa)) {
+                tarefa();
+                continue;
+            }
+            unique_lock<mutex> trava(mutexEspera);
+            cvEspera.wait(trava, [this] { return parar || pendentes > 0; });
+            if (parar && pendentes <= 0) return;
+        }
+    }
+};
+
+vector<string> dividirCampos(const string& linha) {
+    stringstream ss(linha);
+    string campo;
+    vector<string> campos;
+
+    while (getline(ss, campo, ',')) {
+        campos.push_back(campo);
+    }
+    return campos;
+}
+
+shared_ptr<Carta> cartaDeCampos(const vector<string>& campos) {
+    string id = campos[0];
+    string nome = campos[1];
+    int poder = stoi(campos[2]);
+    int resistencia = stoi(campos[3]);
+    float rating = stof(campos[4]);
+    vector<string> tipos = {"Pokémon"};
+
+    if (rating < 0 || rating > 10) {
+        throw out_of_range("Rating deve estar entre 0 e 10");
+    }
+
+    return make_shared<Carta>(id, nome, JogoTipo::POKEMON, poder, resistencia, tipos, rating);
+}
+
+bool cartasIguais(const Carta& a, const Carta& b) {
+    return a.id == b.id && a.nome == b.nome && a.jogo == b.jogo && a.poder == b.poder &&
+           a.resistencia == b.resistencia && a.tipos == b.tipos && a.rating == b.rating;
+}
+
+template <class Chave = ChaveTexto,
+          class Hash = HashPolinomial,
+          class Comparador = less<typename Chave::Tipo>,
+          class Indices = HashOrdenado>
 class GerenciadorCartas {
 private:
+    using TipoChave = conditional_t<Indices::camadas, typename Chave::Propria, typename Chave::Tipo>;
+    using ConsultaChave = typename Chave::Tipo;
+
+    static_assert(is_invocable_r_v<size_t, const Hash&, const TipoChave&> &&
+                  is_invocable_r_v<size_t, const Hash&, const ConsultaChave&>,
+                  "Hash deve calcular size_t a partir do tipo de chave");
+    static_assert(is_invocable_r_v<bool, const Comparador&, const TipoChave&, const TipoChave&>,
+                  "Comparador deve ordenar o tipo de chave");
+
+    struct Vazio {};
+
+    struct EntradaSimples {
+        TipoChave chave;
+        shared_ptr<const Carta> carta;
+        EntradaSimples(TipoChave k, shared_ptr<const Carta> c) : chave(move(k)), carta(move(c)) {}
+    };
+
+    // Handle do modo em camadas, sempre em memória: chave e rating ficam na entrada
+    // para que índices e filtros não precisem da carta, que fica nula enquanto está
+    // despejada. carta é lida e trocada com atomic_load/atomic_store, então um
+    // acerto não passa pelo mutex.
+    struct EntradaCamadas {
+        TipoChave chave;
+        float rating;
+        mutable shared_ptr<const Carta> carta;
+        mutable int64_t deslocamento = -1;
+        mutable atomic<bool> referenciada{false};
+        EntradaCamadas(TipoChave k, shared_ptr<const Carta> c) : chave(move(k)), rating(c->rating), carta(move(c)) {}
+
+        // Só escreve se o bit estiver limpo, para cartas quentes não disputarem a linha de cache.
+        void marcar() const {
+            if (!referenciada.load(memory_order_relaxed)) referenciada.store(true, memory_order_relaxed);
+        }
+    };
+
+    using Entrada = conditional_t<Indices::camadas, EntradaCamadas, EntradaSimples>;
+
     struct NodeAVL {
-        shared_ptr<Carta> carta;
+        const Entrada* entrada;
         unique_ptr<NodeAVL> esquerda;
         unique_ptr<NodeAVL> direita;
         int altura;
-        NodeAVL(shared_ptr<Carta> c) : carta(c), altura(1) {}
+        NodeAVL(const Entrada* e) : entrada(e), altura(1) {}
     };
 
     struct NodeBST {
-        shared_ptr<Carta> carta;
+        shared_ptr<const Carta> carta;
         unique_ptr<NodeBST> esquerda;
         unique_ptr<NodeBST> direita;
-        NodeBST(shared_ptr<Carta> c) : carta(c) {}
+        NodeBST(shared_ptr<const Carta> c) : carta(c) {}
     };
 
-    vector<list<shared_ptr<Carta>>> tabelaHash;
+    vector<list<Entrada>> tabelaHash;
     int tamanho;
     int capacidade;
     const float LIMITE_CARGA = 0.7f;
-    unique_ptr<NodeAVL> raizAVL;
+    conditional_t<Indices::ordenado, unique_ptr<NodeAVL>, Vazio> raizAVL;
+    conditional_t<Indices::porRating, multimap<float, const Entrada*>, Vazio> indiceRating;
+    conditional_t<Indices::agregados, AgregadosCartas, Vazio> agregados;
+
+    // Estado da última sincronização de um arquivo: IDs de cada bloco, pelo checksum
+    // do bloco, e a impressão digital da linha de cada carta com a última
+    // sincronização em que o ID foi visto.
+    struct Impressao {
+        uint64_t hash;
+        int geracao;
+    };
+
+    struct EstadoSincronizacao {
+        unordered_map<uint64_t, vector<string>> blocos;
+        unordered_map<string, Impressao> impressoes;
+        int geracao = 0;
+    };
+    unordered_map<string, EstadoSincronizacao> sincronizacoes;
+
+    // Modo com orçamento de memória: cartas pouco usadas são gravadas no arquivo de
+    // páginas e descartadas. A própria tabela hash serve de anel para o CLOCK.
+    // Exceto acertos e as cartas das entradas, o estado exige o mutex m.
+    struct EstadoCamadas {
+        // O arquivo é regravado quando as páginas de cartas removidas passam desse
+        // mínimo e das páginas vivas, então fica com no máximo o dobro do necessário.
+        static constexpr int MINIMO_PAGINAS_MORTAS = 1024;
+
+        bool ativo = false;
+        size_t orcamento = 0;
+        size_t bytesResidentes = 0;
+        int residentes = 0;
+        size_t ponteiro = 0;
+        fstream arquivo;
+        string caminho;
+        int paginasVivas = 0;
+        int paginasMortas = 0;
+        int limiteCompactacao = MINIMO_PAGINAS_MORTAS;
+        mutex m;
+        atomic<long long> acertos{0};
+        long long faltas = 0;
+        long long leiturasVarredura = 0;
+        long long despejos = 0;
+        long long gravacoes = 0;
+        long long compactacoes = 0;
+
+        void reiniciar() {
+            ativo = false;
+            orcamento = 0;
+            bytesResidentes = 0;
+            residentes = 0;
+            ponteiro = 0;
+            caminho.clear();
+            paginasVivas = 0;
+            paginasMortas = 0;
+            limiteCompactacao = MINIMO_PAGINAS_MORTAS;
+            acertos = 0;
+            faltas = 0;
+            leiturasVarredura = 0;
+            despejos = 0;
+            gravacoes = 0;
+            compactacoes = 0;
+        }
+
+        static size_t tamanhoEstimado(const Carta& c) {
+            size_t bytes = sizeof(Carta) + 16 + c.id.capacity() + c.nome.capacity();
+            for (const auto& t : c.tipos) {
+                bytes += sizeof(string) + t.capacity();
+            }
+            return bytes;
+        }
+
+        int64_t gravarPagina(const Carta& c) {
+            return gravarPagina(arquivo, c);
+        }
+
+        int64_t gravarPagina(fstream& arquivo, const Carta& c) {
+            arquivo.seekp(0, ios::end);
+            int64_t deslocamento = arquivo.tellp();
+
+            auto gravarTexto = [&](const string& texto) {
+                uint32_t n = texto.size();
+                arquivo.write(reinterpret_cast<const char*>(&n), sizeof(n));
+                arquivo.write(texto.data(), n);
+            };
+            int32_t numeros[] = {static_cast<int32_t>(c.jogo), c.poder, c.resistencia};
+            arquivo.write(reinterpret_cast<const char*>(numeros), sizeof(numeros));
+            arquivo.write(reinterpret_cast<const char*>(&c.rating), sizeof(c.rating));
+            gravarTexto(c.id);
+            gravarTexto(c.nome);
+            uint32_t quantidadeTipos = c.tipos.size();
+            arquivo.write(reinterpret_cast<const char*>(&quantidadeTipos), sizeof(quantidadeTipos));
+            for (const auto& t : c.tipos) {
+                gravarTexto(t);
+            }
+
+            if (!arquivo) {
+                throw runtime_error("Falha ao gravar no arquivo de páginas: " + caminho);
+            }
+            return deslocamento;
+        }
+
+        shared_ptr<const Carta> lerPagina(int64_t deslocamento) {
+            return lerPagina(arquivo, deslocamento);
+        }
+
+        shared_ptr<const Carta> lerPagina(fstream& arquivo, int64_t deslocamento) {
+            arquivo.seekg(deslocamento);
+
+            auto lerTexto = [&]() {
+                uint32_t n = 0;
+                arquivo.read(reinterpret_cast<char*>(&n), sizeof(n));
+                string texto(n, '\0');
+                arquivo.read(texto.data(), n);
+                return texto;
+            };
+            int32_t numeros[3];
+            float rating;
+            arquivo.read(reinterpret_cast<char*>(numeros), sizeof(numeros));
+            arquivo.read(reinterpret_cast<char*>(&rating), sizeof(rating));
+            string id = lerTexto();
+            string nome = lerTexto();
+            uint32_t quantidadeTipos = 0;
+            arquivo.read(reinterpret_cast<char*>(&quantidadeTipos), sizeof(quantidadeTipos));
+            vector<string> tipos;
+            for (uint32_t i = 0; i < quantidadeTipos && arquivo; i++) {
+                tipos.push_back(lerTexto());
+            }
+
+            if (!arquivo) {
+                throw runtime_error("Falha ao ler do arquivo de páginas: " + caminho);
+            }
+            return make_shared<Carta>(id, nome, static_cast<JogoTipo>(numeros[0]), numeros[1], numeros[2], tipos, rating);
+        }
+
+        // Com admitir, a carta volta a ser residente e conta como acesso; sem, é
+        // lida do disco só para quem pediu (varreduras).
+        shared_ptr<const Carta> carregar(const EntradaCamadas& e, bool admitir) {
+            if (e.carta) {
+                if (admitir) {
+                    e.marcar();
+                    acertos.fetch_add(1, memory_order_relaxed);
+                }
+                return e.carta;
+            }
+
+            shared_ptr<const Carta> carta = lerPagina(e.deslocamento);
+            if (!admitir) {
+                leiturasVarredura++;
+                return carta;
+            }
+            faltas++;
+            e.marcar();
+            bytesResidentes += tamanhoEstimado(*carta);
+            residentes++;
+            atomic_store(&e.carta, carta);
+            return carta;
+        }
+
+        void despejar(const EntradaCamadas& e) {
+            if (e.deslocamento < 0) {
+                e.deslocamento = gravarPagina(*e.carta);
+                gravacoes++;
+                paginasVivas++;
+            }
+            bytesResidentes -= tamanhoEstimado(*e.carta);
+            residentes--;
+            despejos++;
+            atomic_store(&e.carta, shared_ptr<const Carta>());
+        }
+
+        // Avança o ponteiro do CLOCK pelos buckets: entradas referenciadas ganham
+        // outra volta, as demais são despejadas.
+        void despejarExcedente(const vector<list<EntradaCamadas>>& tabela) {
+            size_t passos = 0;
+            while (bytesResidentes > orcamento && passos++ <= 2 * tabela.size()) {
+                const auto& bucket = tabela[ponteiro % tabela.size()];
+                ponteiro = (ponteiro + 1) % tabela.size();
+                for (const auto& e : bucket) {
+                    if (!e.carta) continue;
+                    if (e.referenciada.exchange(false, memory_order_relaxed)) continue;
+                    despejar(e);
+                }
+            }
+        }
+
+        // Chamado antes de a entrada sair da tabela: libera a carta e marca a
+        // página como morta. Não falha, então a remoção nunca fica pela metade.
+        void descartar(const EntradaCamadas& e) {
+            if (e.carta) {
+                bytesResidentes -= tamanhoEstimado(*e.carta);
+                residentes--;
+            }
+            if (e.deslocamento >= 0) {
+                e.deslocamento = -1;
+                paginasVivas--;
+                paginasMortas++;
+            }
+        }
+
+        // Chamado depois que uma remoção terminou.
+        void compactarSeNecessario(const vector<list<EntradaCamadas>>& tabela) {
+            if (paginasMortas >= limiteCompactacao && paginasMortas > paginasVivas) {
+                compactar(tabela);
+            }
+        }
 
-    size_t hash(const string& id, int tentativa = 0, int cap = -1) const {
+        // Copia só as páginas vivas para um arquivo novo, que substitui o atual. Os
+        // deslocamentos só mudam depois da troca; se algo falhar, o arquivo atual
+        // continua valendo e a próxima tentativa espera o dobro de páginas mortas.
+        bool compactar(const vector<list<EntradaCamadas>>& tabela) {
+            string temporario = caminho + ".tmp";
+            fstream novo(temporario, ios::in | ios::out | ios::binary | ios::trunc);
+            vector<pair<const EntradaCamadas*, int64_t>> deslocamentos;
+            bool copiado = novo.is_open();
+            try {
+                for (size_t i = 0; copiado && i < tabela.size(); i++) {
+                    for (const auto& e : tabela[i]) {
+                        if (e.deslocamento < 0) continue;
+                        shared_ptr<const Carta> carta = e.carta ? e.carta : lerPagina(e.deslocamento);
+                        deslocamentos.emplace_back(&e, gravarPagina(novo, *carta));
+                    }
+                }
+                copiado = copiado && novo.flush();
+            } catch (const exception&) {
+                copiado = false;
+            }
+
+            // O arquivo novo é renomeado ainda aberto, então não precisa ser reaberto.
+            if (!copiado || rename(temporario.c_str(), caminho.c_str()) != 0) {
+                novo.close();
+                remove(temporario.c_str());
+                arquivo.clear();
+                limiteCompactacao = max(MINIMO_PAGINAS_MORTAS, paginasMortas * 2);
+                return false;
+            }
+            arquivo = move(novo);
+            for (const auto& [e, deslocamento] : deslocamentos) {
+                e->deslocamento = deslocamento;
+            }
+            paginasMortas = 0;
+            limiteCompactacao = MINIMO_PAGINAS_MORTAS;
+            compactacoes++;
+            return true;
+        }
+    };
+    mutable conditional_t<Indices::camadas, EstadoCamadas, Vazio> camadas;
+
+    // bucketsPorTamanho[k] = quantidade de buckets com k cartas.
+    vector<int> bucketsPorTamanho;
+    int maiorBucket = 0;
+
+    static constexpr size_t DISTANCIA_PREFETCH = 16;
+    static constexpr size_t BUCKETS_POR_MORSEL = 4096;
+    // Blocos terminam numa linha cujo hash é múltiplo de LINHAS_POR_BLOCO, então
+    // uma inserção ou remoção de linha desloca só o bloco em que ocorreu.
+    static constexpr uint64_t LINHAS_POR_BLOCO = 64;
+    static constexpr size_t MAXIMO_LINHAS_BLOCO = 8 * LINHAS_POR_BLOCO;
+    static constexpr size_t SEM_INDICE = static_cast<size_t>(-1);
+
+    template <class K>
+    size_t hash(const K& chave, int cap = -1) const {
         if (cap == -1) cap = capacidade;
-        
-        size_t h = 0;
-        for (char c : id) {
-            h = h * 31 + c;
+        return Hash{}(chave) % cap;
+    }
+
+    static bool menor(const TipoChave& a, const TipoChave& b) {
+        return Comparador{}(a, b);
+    }
+
+    const Entrada* buscarEntrada(const ConsultaChave& chave) const {
+        for (const auto& e : tabelaHash[hash(chave)]) {
+            if (e.chave == chave) return &e;
         }
-        
-        size_t h2 = 1 + (h % (capacidade - 1));
-        
-        return (h + tentativa * h2) % capacidade;
+        return nullptr;
     }
 
     void rehash() {
         int novaCapacidade = capacidade * 2;
-        vector<list<shared_ptr<Carta>>> novaTabela(novaCapacidade);
+        vector<list<Entrada>> novaTabela(novaCapacidade);
         
         for (auto& bucket : tabelaHash) {
-            for (auto& carta : bucket) {
-                size_t indice = hash(carta->id, 0, novaCapacidade);
-                novaTabela[indice].push_back(carta);
+            while (!bucket.empty()) {
+                size_t indice = hash(bucket.front().chave, novaCapacidade);
+                novaTabela[indice].splice(novaTabela[indice].end(), bucket, bucket.begin());
             }
         }
         
         tabelaHash = move(novaTabela);
         capacidade = novaCapacidade;
+        recalcularBuckets();
+    }
+
+    void recalcularBuckets() {
+        bucketsPorTamanho.assign(1, 0);
+        maiorBucket = 0;
+        for (const auto& bucket : tabelaHash) {
+            size_t n = bucket.size();
+            if (n >= bucketsPorTamanho.size()) bucketsPorTamanho.resize(n + 1, 0);
+            bucketsPorTamanho[n]++;
+            maiorBucket = max(maiorBucket, static_cast<int>(n));
+        }
+    }
+
+    void atualizarBucket(size_t antes, size_t depois) {
+        bucketsPorTamanho[antes]--;
+        if (depois >= bucketsPorTamanho.size()) bucketsPorTamanho.resize(depois + 1, 0);
+        bucketsPorTamanho[depois]++;
+        maiorBucket = max(maiorBucket, static_cast<int>(depois));
+        while (maiorBucket > 0 && bucketsPorTamanho[maiorBucket] == 0) maiorBucket--;
+    }
+
+    static float ratingDe(const Entrada& e) {
+        if constexpr (Indices::camadas) {
+            return e.rating;
+        } else {
+            return e.carta->rating;
+        }
+    }
+
+    // Um acerto copia a carta com atomic_load, sem mutex; só a falta trava o
+    // estado das camadas para ler o arquivo de páginas e, ao admitir, despejar.
+    shared_ptr<const Carta> obter(const Entrada& e, bool admitir = true) const {
+        if constexpr (!Indices::camadas) {
+            return e.carta;
+        } else {
+            if (!camadas.ativo) return e.carta;
+            if (shared_ptr<const Carta> carta = atomic_load(&e.carta)) {
+                if (admitir) {
+                    e.marcar();
+                    camadas.acertos.fetch_add(1, memory_order_relaxed);
+                }
+                return carta;
+            }
+            lock_guard<mutex> trava(camadas.m);
+            shared_ptr<const Carta> carta = camadas.carregar(e, admitir);
+            if (admitir) camadas.despejarExcedente(tabelaHash);
+            return carta;
+        }
+    }
+
+    // Acesso de varredura: não copia o shared_ptr fora do modo com orçamento e não
+    // traz cartas frias de volta para a memória.
+    template <class F>
+    void comCarta(const Entrada& e, F&& f) const {
+        if constexpr (Indices::camadas) {
+            if (camadas.ativo) {
+                f(obter(e, false));
+                return;
+            }
+        }
+        f(e.carta);
+    }
+
+    struct TodasEntradas {
+        bool operator()(const Entrada&) const { return true; }
+    };
+
+    // PreFiltro decide só pelos campos da entrada, antes de a carta ser lida do
+    // arquivo de páginas; Filtro vê a carta das entradas aceitas.
+    template <class Filtro, class PreFiltro = TodasEntradas>
+    void filtrarBuckets(size_t inicio, size_t fim, Filtro filtro, vector<shared_ptr<const Carta>>& resultados,
+                        PreFiltro preFiltro = {}) const {
+        for (size_t i = inicio; i < fim; i++) {
+            for (const auto& e : tabelaHash[i]) {
+                if (!preFiltro(e)) continue;
+                comCarta(e, [&](const shared_ptr<const Carta>& carta) {
+                    if (filtro(*carta)) {
+                        resultados.push_back(carta);
+                    }
+                });
+            }
+        }
+    }
+
+    // Divide a tabela em faixas de buckets e filtra cada faixa em uma tarefa do pool.
+    template <class Filtro, class PreFiltro = TodasEntradas>
+    vector<shared_ptr<const Carta>> filtrarBucketsParalelo(Filtro filtro, PoolTrabalho& pool, PreFiltro preFiltro = {}) const {
+        size_t quantidade = (tabelaHash.size() + BUCKETS_POR_MORSEL - 1) / BUCKETS_POR_MORSEL;
+        vector<vector<shared_ptr<const Carta>>> partes(quantidade);
+        vector<future<void>> tarefas;
+        for (size_t p = 0; p < quantidade; p++) {
+            size_t inicio = p * BUCKETS_POR_MORSEL;
+            size_t fim = min(tabelaHash.size(), inicio + BUCKETS_POR_MORSEL);
+            tarefas.push_back(pool.submeter([this, filtro, preFiltro, inicio, fim, &partes, p] {
+                filtrarBuckets(inicio, fim, filtro, partes[p], preFiltro);
+            }));
+        }
+        for (auto& t : tarefas) pool.aguardar(t);
+        return concatenar(partes);
+    }
+
+    static vector<shared_ptr<const Carta>> concatenar(vector<vector<shared_ptr<const Carta>>>& partes) {
+        size_t total = 0;
+        for (const auto& p : partes) total += p.size();
+        vector<shared_ptr<const Carta>> resultados;
+        resultados.reserve(total);
+        for (auto& p : partes) {
+            move(p.begin(), p.end(), back_inserter(resultados));
+        }
+        return resultados;
+    }
+
+    void coletarPorRating(const NodeAVL* node, float min, float max, vector<shared_ptr<const Carta>>& resultados) const {
+        if (!node) return;
+        coletarPorRating(node->esquerda.get(), min, max, resultados);
+        if (ratingDe(*node->entrada) >= min && ratingDe(*node->entrada) <= max) {
+            comCarta(*node->entrada, [&](const shared_ptr<const Carta>& carta) { resultados.push_back(carta); });
+        }
+        coletarPorRating(node->direita.get(), min, max, resultados);
+    }
+
+    // Percorre as entradas em ordem de chave quando há índice ordenado,
+    // senão na ordem dos buckets.
+    template <class F>
+    void paraCadaEntrada(F&& f) const {
+        if constexpr (Indices::ordenado) {
+            function<void(const unique_ptr<NodeAVL>&)> inOrder = [&](const unique_ptr<NodeAVL>& node) {
+                if (!node) return;
+                inOrder(node->esquerda);
+                f(*node->entrada);
+                inOrder(node->direita);
+            };
+            inOrder(raizAVL);
+        } else {
+            for (const auto& bucket : tabelaHash) {
+                for (const auto& e : bucket) {
+                    f(e);
+                }
+            }
+        }
+    }
+
+    template <class F>
+    void paraCadaCarta(F&& f) const {
+        paraCadaEntrada([&](const Entrada& e) { comCarta(e, f); });
     }
 
     int altura(const unique_ptr<NodeAVL>& node) const {
@@ -110,28 +868,29 @@ private:
         return y;
     }
 
-    unique_ptr<NodeAVL> inserirAVL(unique_ptr<NodeAVL> node, shared_ptr<Carta> carta) {
-        if (!node) return make_unique<NodeAVL>(carta);
+    unique_ptr<NodeAVL> inserirAVL(unique_ptr<NodeAVL> node, const Entrada* entrada) {
+        if (!node) return make_unique<NodeAVL>(entrada);
 
-        if (carta->id < node->carta->id)
-            node->esquerda = inserirAVL(move(node->esquerda), carta);
-        else if (carta->id > node->carta->id)
-            node->direita = inserirAVL(move(node->direita), carta);
+        const TipoChave& chave = entrada->chave;
+        if (menor(chave, node->entrada->chave))
+            node->esquerda = inserirAVL(move(node->esquerda), entrada);
+        else if (menor(node->entrada->chave, chave))
+            node->direita = inserirAVL(move(node->direita), entrada);
         else
             return node;
 
         node->altura = 1 + max(altura(node->esquerda), altura(node->direita));
         int balance = altura(node->esquerda) - altura(node->direita);
 
-        if (balance > 1 && carta->id < node->esquerda->carta->id)
+        if (balance > 1 && menor(chave, node->esquerda->entrada->chave))
             return rotacionarDireita(move(node));
-        if (balance < -1 && carta->id > node->direita->carta->id)
+        if (balance < -1 && menor(node->direita->entrada->chave, chave))
             return rotacionarEsquerda(move(node));
-        if (balance > 1 && carta->id > node->esquerda->carta->id) {
+        if (balance > 1 && menor(node->esquerda->entrada->chave, chave)) {
             node->esquerda = rotacionarEsquerda(move(node->esquerda));
             return rotacionarDireita(move(node));
         }
-        if (balance < -1 && carta->id < node->direita->carta->id) {
+        if (balance < -1 && menor(chave, node->direita->entrada->chave)) {
             node->direita = rotacionarDireita(move(node->direita));
             return rotacionarEsquerda(move(node));
         }
@@ -147,7 +906,7 @@ private:
             imprimirBST(node->esquerda, prefix + (isLeft ? "    " : "│   "), true);
     }
 
-    void inserirBST(unique_ptr<NodeBST>& raiz, shared_ptr<Carta> carta) {
+    void inserirBST(unique_ptr<NodeBST>& raiz, shared_ptr<const Carta> carta) {
       if (!raiz) {
           raiz = make_unique<NodeBST>(carta);
       } else {
@@ -161,12 +920,12 @@ private:
 
     void montarBSTPorRating(float rating, bool maiorQue) {
       unique_ptr<NodeBST> raizBST;
-      vector<shared_ptr<Carta>> cartasFiltradas;
+      vector<shared_ptr<const Carta>> cartasFiltradas;
       
       for (auto& bucket : tabelaHash) {
-          for (auto& carta : bucket) {
-              if ((maiorQue && carta->rating > rating) || (!maiorQue && carta->rating < rating)) {
-                  cartasFiltradas.push_back(carta);
+          for (auto& e : bucket) {
+              if ((maiorQue && ratingDe(e) > rating) || (!maiorQue && ratingDe(e) < rating)) {
+                  comCarta(e, [&](const shared_ptr<const Carta>& carta) { cartasFiltradas.push_back(carta); });
               }
           }
       }
@@ -225,6 +984,10 @@ private:
 
                     string id = item["id"];
                     string nome = item["name"];
+                    if (!Chave::converter(id)) {
+                        cerr << "Aviso: ID " << id << " incompatível com o tipo de chave, pulando...\n";
+                        continue;
+                    }
                     
                     int poder = 0;
                     if (item.contains("hp") && item["hp"].is_string()) {
@@ -249,16 +1012,26 @@ private:
     }
 
 public:
+    // Resultado de buscarPorIds: dono da carta quando ela pode ser despejada.
+    using ReferenciaLote = conditional_t<Indices::camadas, shared_ptr<const Carta>, const Carta*>;
+
     GerenciadorCartas(int cap = 100) : tamanho(0), capacidade(max(2, cap)) {
         tabelaHash.resize(capacidade);
+        recalcularBuckets();
     }
 
-    bool cartaExiste(const string& id) const {
-        size_t indice = hash(id);
-        for (const auto& c : tabelaHash[indice]) {
-            if (c->id == id) return true;
+    ~GerenciadorCartas() {
+        if constexpr (Indices::camadas) {
+            if (camadas.ativo) {
+                camadas.arquivo.close();
+                remove(camadas.caminho.c_str());
+            }
         }
-        return false;
+    }
+
+    bool cartaExiste(const string& id) const {
+        auto chave = Chave::converter(id);
+        return chave && buscarEntrada(*chave);
     }
 
     int lerInteiro(const string& mensagem) {
@@ -311,13 +1084,7 @@ public:
                 continue;
             }
 
-            stringstream ss(linha);
-            string campo;
-            vector<string> campos;
-
-            while (getline(ss, campo, ',')) {
-                campos.push_back(campo);
-            }
+            vector<string> campos = dividirCampos(linha);
 
             if (campos.size() < 5) {
                 erros++;
@@ -332,17 +1099,11 @@ public:
                     continue;
                 }
 
-                string nome = campos[1];
-                int poder = stoi(campos[2]);
-                int resistencia = stoi(campos[3]);
-                float rating = stof(campos[4]);
-                vector<string> tipos = {"Pokémon"};
-
-                if (rating < 0 || rating > 10) {
-                    throw out_of_range("Rating deve estar entre 0 e 10");
+                if (!Chave::converter(id)) {
+                    throw invalid_argument("ID incompatível com o tipo de chave");
                 }
 
-                adicionarCarta(std::make_shared<Carta>(id, nome, JogoTipo::POKEMON, poder, resistencia, tipos, rating));
+                adicionarCarta(cartaDeCampos(campos));
                 contador++;
             } catch (const exception& e) {
                 erros++;
@@ -355,51 +1116,371 @@ public:
         }
     }
 
-    void adicionarCarta(shared_ptr<Carta> carta) {
+    // Recarrega o arquivo aplicando apenas as diferenças desde a última sincronização:
+    // blocos com checksum conhecido não são interpretados, linhas alteradas substituem
+    // a carta e IDs que sumiram do arquivo são removidos.
+    void sincronizarCSV(const string& caminho) {
+        ifstream arquivo(caminho);
+        if (!arquivo.is_open()) {
+            cerr << "Erro ao abrir arquivo: " << caminho << endl;
+            return;
+        }
+
+        EstadoSincronizacao& estado = sincronizacoes[caminho];
+        const int geracao = ++estado.geracao;
+        unordered_map<uint64_t, vector<string>> blocos;
+        int blocosPulados = 0, blocosLidos = 0;
+        int inseridas = 0, atualizadas = 0, removidas = 0, erros = 0;
+        int numeroLinha = 1;
+
+        vector<string> linhas;
+        vector<uint64_t> hashes;
+        uint64_t checksum = 0;
+
+        auto processarBloco = [&]() {
+            if (linhas.empty()) return;
+
+            auto conhecido = estado.blocos.find(checksum);
+            if (blocos.count(checksum)) {
+                blocosPulados++;
+            } else if (conhecido != estado.blocos.end() &&
+                       all_of(conhecido->second.begin(), conhecido->second.end(),
+                              [&](const string& id) { return cartaExiste(id); })) {
+                for (const auto& id : conhecido->second) {
+                    estado.impressoes[id].geracao = geracao;
+                }
+                blocos[checksum] = move(conhecido->second);
+                blocosPulados++;
+            } else {
+                vector<string> ids;
+                bool repetido = false;
+                for (size_t i = 0; i < linhas.size(); i++) {
+                    int linhaArquivo = numeroLinha - static_cast<int>(linhas.size()) + static_cast<int>(i) + 1;
+                    string id = linhas[i].substr(0, linhas[i].find(','));
+                    auto impressao = estado.impressoes.find(id);
+                    // Como em inserirPorCSV, vale a primeira linha de cada ID.
+                    if (impressao != estado.impressoes.end() && impressao->second.geracao == geracao) {
+                        cout << "Aviso: ID " << id << " repetido na linha " << linhaArquivo << ", pulando...\n";
+                        repetido = true;
+                        continue;
+                    }
+                    const Entrada* entrada = nullptr;
+                    if (auto chave = Chave::converter(id)) entrada = buscarEntrada(*chave);
+                    bool existe = entrada != nullptr;
+                    if (existe && impressao != estado.impressoes.end() && impressao->second.hash == hashes[i]) {
+                        impressao->second.geracao = geracao;
+                        ids.push_back(id);
+                        continue;
+                    }
+
+                    try {
+                        vector<string> campos = dividirCampos(linhas[i]);
+                        if (campos.size() < 5) {
+                            throw invalid_argument("Número insuficiente de campos (" + to_string(campos.size()) + ")");
+                        }
+                        auto carta = cartaDeCampos(campos);
+                        // Sem impressão (carta vinda de inserirPorCSV ou da API), uma
+                        // linha igual à carta atual só registra a impressão.
+                        if (!existe || !cartasIguais(*obter(*entrada, false), *carta)) {
+                            if (existe) removerCarta(id);
+                            adicionarCarta(carta);
+                            if (existe) {
+                                atualizadas++;
+                            } else {
+                                inseridas++;
+                            }
+                        }
+                        estado.impressoes[id] = {hashes[i], geracao};
+                        ids.push_back(id);
+                    } catch (const exception& e) {
+                        erros++;
+                        cerr << "Erro na linha " << linhaArquivo << ": " << e.what() << endl;
+                        // Uma edição inválida não apaga a carta: a versão atual continua
+                        // valendo e a linha será relida quando o bloco mudar de novo.
+                        if (existe && cartaExiste(id)) {
+                            estado.impressoes[id].geracao = geracao;
+                            ids.push_back(id);
+                        }
+                    }
+                }
+                // Um bloco com ID repetido é sempre relido: se a primeira ocorrência
+                // sumir do arquivo, a seguinte passa a valer.
+                if (!repetido) blocos[checksum] = move(ids);
+                blocosLidos++;
+            }
+
+            linhas.clear();
+            hashes.clear();
+            checksum = 0;
+        };
+
+        string linha;
+        getline(arquivo, linha);
+        while (getline(arquivo, linha)) {
+            numeroLinha++;
+            uint64_t h = HashFNV1a{}(linha);
+            checksum = (checksum ^ h) * 1099511628211ULL;
+            linhas.push_back(move(linha));
+            hashes.push_back(h);
+            if (h % LINHAS_POR_BLOCO == 0 || linhas.size() >= MAXIMO_LINHAS_BLOCO) {
+                processarBloco();
+            }
+        }
+        processarBloco();
+
+        for (auto it = estado.impressoes.begin(); it != estado.impressoes.end();) {
+            if (it->second.geracao == geracao) {
+                ++it;
+                continue;
+            }
+            if (removerCarta(it->first)) removidas++;
+            it = estado.impressoes.erase(it);
+        }
+        estado.blocos = move(blocos);
+
+        cout << "Sincronização concluída: " << inseridas << " inseridas, " << atualizadas
+             << " atualizadas, " << removidas << " removidas\n";
+        cout << "Blocos sem alteração: " << blocosPulados << " | Blocos relidos: " << blocosLidos << endl;
+        if (erros > 0) {
+            cout << "Erros encontrados: " << erros << endl;
+        }
+    }
+
+    // A carta passa a ser compartilhada com os índices e não deve mais ser alterada:
+    // a chave de texto aponta para o id e os agregados guardam seus atributos.
+    // Por isso as buscas devolvem shared_ptr<const Carta>.
+    void adicionarCarta(shared_ptr<const Carta> carta) {
+        auto chave = Chave::converter(carta->id);
+        if (!chave) {
+            throw invalid_argument("ID incompatível com o tipo de chave: " + carta->id);
+        }
+
         float fatorCarga = static_cast<float>(tamanho + 1) / capacidade;
         if (fatorCarga >= LIMITE_CARGA) rehash();
 
-        size_t indice = hash(carta->id);
-        tabelaHash[indice].push_back(carta);
+        size_t indice = hash(*chave);
+        tabelaHash[indice].emplace_back(TipoChave(*chave), carta);
+        const Entrada* entrada = &tabelaHash[indice].back();
+        atualizarBucket(tabelaHash[indice].size() - 1, tabelaHash[indice].size());
         tamanho++;
-        raizAVL = inserirAVL(move(raizAVL), carta);
+        if constexpr (Indices::ordenado) {
+            raizAVL = inserirAVL(move(raizAVL), entrada);
+        }
+        if constexpr (Indices::porRating) {
+            indiceRating.emplace(carta->rating, entrada);
+        }
+        if constexpr (Indices::agregados) {
+            agregados.adicionar(*carta);
+        }
+        if constexpr (Indices::camadas) {
+            if (camadas.ativo) {
+                lock_guard<mutex> trava(camadas.m);
+                camadas.bytesResidentes += EstadoCamadas::tamanhoEstimado(*carta);
+                camadas.residentes++;
+                camadas.despejarExcedente(tabelaHash);
+            }
+        }
     }
 
-    shared_ptr<Carta> buscarPorId(const string& id) const {
-        size_t indice = hash(id);
-        for (const auto& c : tabelaHash[indice]) {
-            if (c->id == id) return c;
+    bool removerCarta(const string& id) {
+        auto chave = Chave::converter(id);
+        if (!chave) return false;
+
+        auto& bucket = tabelaHash[hash(*chave)];
+        auto it = find_if(bucket.begin(), bucket.end(), [&](const Entrada& e) { return e.chave == *chave; });
+        if (it == bucket.end()) return false;
+
+        const Entrada* entrada = &*it;
+        // Primeiro o que pode falhar (ler a carta do disco), para não deixar os
+        // índices pela metade.
+        if constexpr (Indices::agregados) {
+            agregados.remover(*obter(*entrada, false));
         }
-        return nullptr;
+        if constexpr (Indices::ordenado) {
+            raizAVL = removerAVL(move(raizAVL), entrada->chave);
+        }
+        if constexpr (Indices::porRating) {
+            auto [inicio, fim] = indiceRating.equal_range(ratingDe(*entrada));
+            for (auto r = inicio; r != fim; ++r) {
+                if (r->second == entrada) {
+                    indiceRating.erase(r);
+                    break;
+                }
+            }
+        }
+        if constexpr (Indices::camadas) {
+            if (camadas.ativo) {
+                lock_guard<mutex> trava(camadas.m);
+                camadas.descartar(*entrada);
+            }
+        }
+
+        bucket.erase(it);
+        atualizarBucket(bucket.size() + 1, bucket.size());
+        tamanho--;
+        if constexpr (Indices::camadas) {
+            if (camadas.ativo) {
+                lock_guard<mutex> trava(camadas.m);
+                camadas.compactarSeNecessario(tabelaHash);
+            }
+        }
+        return true;
     }
 
-    vector<shared_ptr<Carta>> buscarPorNome(const string& nome) const {
-        vector<shared_ptr<Carta>> resultados;
-        for (const auto& bucket : tabelaHash) {
-            for (const auto& c : bucket) {
-                if (c->nome.find(nome) != string::npos) {
-                    resultados.push_back(c);
+    int quantidadeCartas() const {
+        return tamanho;
+    }
+
+    shared_ptr<const Carta> buscarPorId(const string& id) const {
+        auto chave = Chave::converter(id);
+        if (!chave) return nullptr;
+        const Entrada* e = buscarEntrada(*chave);
+        return e ? obter(*e) : nullptr;
+    }
+
+    // Busca em lote: calcula todos os índices antes e faz prefetch do bucket, do nó
+    // e da carta alguns IDs à frente. saida recebe nullptr para IDs não encontrados.
+    // Sem ComCamadas, são ponteiros não-proprietários, válidos enquanto a carta não
+    // for removida. Com ComCamadas, uma consulta concorrente pode despejar a carta a
+    // qualquer momento, então saida recebe shared_ptr que a mantêm viva.
+    size_t buscarPorIds(const vector<string_view>& ids, vector<ReferenciaLote>& saida) const {
+        const size_t n = ids.size();
+        saida.assign(n, nullptr);
+
+        unique_lock<mutex> trava;
+        if constexpr (Indices::camadas) {
+            if (camadas.ativo) trava = unique_lock<mutex>(camadas.m);
+        }
+
+        vector<ConsultaChave> chaves(n);
+        vector<size_t> indices(n, SEM_INDICE);
+        for (size_t i = 0; i < n; i++) {
+            auto chave = Chave::converter(ids[i]);
+            if (!chave) continue;
+            chaves[i] = *chave;
+            indices[i] = hash(*chave);
+        }
+
+        auto bucketEm = [&](size_t i) -> const list<Entrada>* {
+            if (i >= n || indices[i] == SEM_INDICE) return nullptr;
+            return &tabelaHash[indices[i]];
+        };
+
+        const size_t d = DISTANCIA_PREFETCH;
+        for (size_t i = 0; i < min(n, 2 * d); i++) {
+            if (auto b = bucketEm(i)) __builtin_prefetch(b);
+        }
+
+        size_t encontrados = 0;
+        for (size_t i = 0; i < n; i++) {
+            if (auto b = bucketEm(i + 2 * d)) {
+                __builtin_prefetch(b);
+            }
+            if (auto b = bucketEm(i + d); b && !b->empty()) {
+                __builtin_prefetch(&b->front());
+            }
+            if (auto b = bucketEm(i + d / 2); b && !b->empty()) {
+                __builtin_prefetch(b->front().carta.get());
+            }
+
+            auto b = bucketEm(i);
+            if (!b) continue;
+            for (const auto& e : *b) {
+                if (e.chave == chaves[i]) {
+                    if constexpr (Indices::camadas) {
+                        saida[i] = camadas.ativo ? camadas.carregar(e, true) : e.carta;
+                    } else {
+                        saida[i] = e.carta.get();
+                    }
+                    encontrados++;
+                    break;
                 }
             }
         }
+        if constexpr (Indices::camadas) {
+            if (camadas.ativo) camadas.despejarExcedente(tabelaHash);
+        }
+        return encontrados;
+    }
+
+    vector<shared_ptr<const Carta>> buscarPorNome(const string& nome) const {
+        vector<shared_ptr<const Carta>> resultados;
+        filtrarBuckets(0, tabelaHash.size(), [&](const Carta& c) {
+            return c.nome.find(nome) != string::npos;
+        }, resultados);
         return resultados;
     }
 
-    vector<shared_ptr<Carta>> buscarPorRating(float min, float max) const {
-        vector<shared_ptr<Carta>> resultados;
-        function<void(const unique_ptr<NodeAVL>&)> inOrder = [&](const unique_ptr<NodeAVL>& node) {
-            if (!node) return;
-            inOrder(node->esquerda);
-            if (node->carta->rating >= min && node->carta->rating <= max) {
-                resultados.push_back(node->carta);
+    vector<shared_ptr<const Carta>> buscarPorNomeParalelo(const string& nome, PoolTrabalho& pool) const {
+        return filtrarBucketsParalelo([&nome](const Carta& c) {
+            return c.nome.find(nome) != string::npos;
+        }, pool);
+    }
+
+    vector<shared_ptr<const Carta>> buscarPorRating(float min, float max) const {
+        vector<shared_ptr<const Carta>> resultados;
+        if constexpr (Indices::porRating) {
+            auto fim = indiceRating.upper_bound(max);
+            for (auto it = indiceRating.lower_bound(min); it != fim; ++it) {
+                comCarta(*it->second, [&](const shared_ptr<const Carta>& carta) { resultados.push_back(carta); });
             }
-            inOrder(node->direita);
-        };
-        inOrder(raizAVL);
+        } else {
+            paraCadaEntrada([&](const Entrada& e) {
+                if (ratingDe(e) >= min && ratingDe(e) <= max) {
+                    comCarta(e, [&](const shared_ptr<const Carta>& carta) { resultados.push_back(carta); });
+                }
+            });
+        }
         return resultados;
     }
 
-    void exibirResultadosBusca(const vector<shared_ptr<Carta>>& resultados) const {
+    // Mesmo resultado e ordem de buscarPorRating. Sem índice por rating, a AVL é
+    // cortada em subárvores a uma profundidade fixa e cada uma vira uma tarefa.
+    vector<shared_ptr<const Carta>> buscarPorRatingParalelo(float min, float max, PoolTrabalho& pool) const {
+        if constexpr (Indices::porRating) {
+            return buscarPorRating(min, max);
+        } else if constexpr (!Indices::ordenado) {
+            return filtrarBucketsParalelo([](const Carta&) { return true; }, pool, [min, max](const Entrada& e) {
+                return ratingDe(e) >= min && ratingDe(e) <= max;
+            });
+        } else {
+            int profundidade = 0;
+            while ((1u << profundidade) < pool.quantidadeThreads() * 4 && profundidade < altura(raizAVL) - 1) {
+                profundidade++;
+            }
+
+            // Em ordem: subárvores na profundidade escolhida intercaladas com os nós acima dela.
+            vector<pair<const NodeAVL*, bool>> particoes;
+            function<void(const NodeAVL*, int)> particionar = [&](const NodeAVL* node, int nivel) {
+                if (!node) return;
+                if (nivel == profundidade) {
+                    particoes.push_back({node, true});
+                    return;
+                }
+                particionar(node->esquerda.get(), nivel + 1);
+                particoes.push_back({node, false});
+                particionar(node->direita.get(), nivel + 1);
+            };
+            particionar(raizAVL.get(), 0);
+
+            vector<vector<shared_ptr<const Carta>>> partes(particoes.size());
+            vector<future<void>> tarefas;
+            for (size_t p = 0; p < particoes.size(); p++) {
+                auto [node, subarvore] = particoes[p];
+                if (subarvore) {
+                    tarefas.push_back(pool.submeter([this, node = node, min, max, &partes, p] {
+                        coletarPorRating(node, min, max, partes[p]);
+                    }));
+                } else if (ratingDe(*node->entrada) >= min && ratingDe(*node->entrada) <= max) {
+                    comCarta(*node->entrada, [&](const shared_ptr<const Carta>& carta) { partes[p].push_back(carta); });
+                }
+            }
+            for (auto& t : tarefas) pool.aguardar(t);
+            return concatenar(partes);
+        }
+    }
+
+    void exibirResultadosBusca(const vector<shared_ptr<const Carta>>& resultados) const {
         if (resultados.empty()) {
             cout << "Nenhuma carta encontrada.\n";
             return;
@@ -413,59 +1494,65 @@ public:
     }
 
     void exibirArvoreAVL() const {
-        cout << "\n=== Estrutura da Árvore AVL (por ID) ===\n";
-        function<void(const unique_ptr<NodeAVL>&, string, bool)> printAVL = 
-            [&](const unique_ptr<NodeAVL>& node, const string& prefix, bool isLeft) {
-                if (!node) return;
-                if (node->direita)
-                    printAVL(node->direita, prefix + (isLeft ? "│   " : "    "), false);
-                cout << prefix << (isLeft ? "└── " : "┌── ") << node->carta->nome << " (ID: " << node->carta->id << ", Rating: " << node->carta->rating << ")\n";
-                if (node->esquerda)
-                    printAVL(node->esquerda, prefix + (isLeft ? "    " : "│   "), true);
-            };
-        printAVL(raizAVL, "", true);
-        cout << "\nTotal de cartas: " << tamanho << "\n";
+        if constexpr (!Indices::ordenado) {
+            cout << "\nÍndice ordenado (AVL) desativado nesta configuração.\n";
+        } else {
+            cout << "\n=== Estrutura da Árvore AVL (por ID) ===\n";
+            function<void(const unique_ptr<NodeAVL>&, string, bool)> printAVL = 
+                [&](const unique_ptr<NodeAVL>& node, const string& prefix, bool isLeft) {
+                    if (!node) return;
+                    if (node->direita)
+                        printAVL(node->direita, prefix + (isLeft ? "│   " : "    "), false);
+                    comCarta(*node->entrada, [&](const shared_ptr<const Carta>& carta) {
+                        cout << prefix << (isLeft ? "└── " : "┌── ") << carta->nome << " (ID: " << carta->id << ", Rating: " << carta->rating << ")\n";
+                    });
+                    if (node->esquerda)
+                        printAVL(node->esquerda, prefix + (isLeft ? "    " : "│   "), true);
+                };
+            printAVL(raizAVL, "", true);
+            cout << "\nTotal de cartas: " << tamanho << "\n";
+        }
     }
 
     void exibirArvoreAVLCompleta() const {
         cout << "\n=== Todos os IDs e Ratings ===\n";
-        function<void(const unique_ptr<NodeAVL>&)> inOrder = 
-            [&](const unique_ptr<NodeAVL>& node) {
-                if (!node) return;
-                inOrder(node->esquerda);
-                cout << "ID: " << node->carta->id << " | Nome: " << node->carta->nome << " | Rating: " << node->carta->rating << "\n";
-                inOrder(node->direita);
-            };
-        inOrder(raizAVL);
+        paraCadaCarta([&](const shared_ptr<const Carta>& carta) {
+            cout << "ID: " << carta->id << " | Nome: " << carta->nome << " | Rating: " << carta->rating << "\n";
+        });
     }
 
     void exibirTopCartas(int limite = 20) const {
         cout << "\n=== Top " << limite << " Cartas (Maior Rating) ===\n";
-        
-        priority_queue<
-            shared_ptr<Carta>,
-            vector<shared_ptr<Carta>>,
-            function<bool(shared_ptr<Carta>, shared_ptr<Carta>)>
-        > heap([](const auto& a, const auto& b) { return a->rating > b->rating; });
-    
-        function<void(const unique_ptr<NodeAVL>&)> coletar = [&](const unique_ptr<NodeAVL>& node) {
-            if (!node) return;
-            coletar(node->esquerda);
-            heap.push(node->carta);
-            if (heap.size() > limite) heap.pop();
-            coletar(node->direita);
-        };
-        
-        coletar(raizAVL);
-    
-        vector<shared_ptr<Carta>> topCartas;
-        while (!heap.empty()) {
-            topCartas.push_back(heap.top());
-            heap.pop();
+
+        vector<shared_ptr<const Carta>> topCartas;
+        if constexpr (Indices::porRating) {
+            for (auto it = indiceRating.rbegin(); it != indiceRating.rend() && (int)topCartas.size() < limite; ++it) {
+                comCarta(*it->second, [&](const shared_ptr<const Carta>& carta) { topCartas.push_back(carta); });
+            }
+        } else {
+            // Seleciona pelo rating da entrada e só então lê as cartas escolhidas.
+            priority_queue<
+                const Entrada*,
+                vector<const Entrada*>,
+                function<bool(const Entrada*, const Entrada*)>
+            > heap([](const Entrada* a, const Entrada* b) { return ratingDe(*a) > ratingDe(*b); });
+
+            paraCadaEntrada([&](const Entrada& e) {
+                heap.push(&e);
+                if (heap.size() > limite) heap.pop();
+            });
+
+            vector<const Entrada*> topEntradas;
+            while (!heap.empty()) {
+                topEntradas.push_back(heap.top());
+                heap.pop();
+            }
+
+            for (auto it = topEntradas.rbegin(); it != topEntradas.rend(); ++it) {
+                comCarta(**it, [&](const shared_ptr<const Carta>& carta) { topCartas.push_back(carta); });
+            }
         }
-        
-        reverse(topCartas.begin(), topCartas.end());
-    
+
         for (size_t i = 0; i < topCartas.size(); i++) {
             cout << i+1 << ". ID: " << topCartas[i]->id 
                  << " | Nome: " << topCartas[i]->nome
@@ -474,7 +1561,11 @@ public:
     }
 
     int contarNosAVL() const {
-        return contarNosAVL(raizAVL);
+        if constexpr (Indices::ordenado) {
+            return contarNosAVL(raizAVL);
+        } else {
+            return tamanho;
+        }
     }
 
     void montarBSTDoUsuario() {
@@ -491,21 +1582,21 @@ public:
         montarBSTPorRating(rating, opcao == 1);
     }
 
-    unique_ptr<NodeAVL> removerAVL(unique_ptr<NodeAVL> node, const string& id) {
+    unique_ptr<NodeAVL> removerAVL(unique_ptr<NodeAVL> node, const TipoChave& chave) {
         if (!node) return nullptr;
     
-        if (id < node->carta->id) {
-            node->esquerda = removerAVL(move(node->esquerda), id);
-        } else if (id > node->carta->id) {
-            node->direita = removerAVL(move(node->direita), id);
+        if (menor(chave, node->entrada->chave)) {
+            node->esquerda = removerAVL(move(node->esquerda), chave);
+        } else if (menor(node->entrada->chave, chave)) {
+            node->direita = removerAVL(move(node->direita), chave);
         } else {
             if (!node->esquerda || !node->direita) {
                 node = move(node->esquerda ? node->esquerda : node->direita);
             } else {
                 auto sucessor = node->direita.get();
                 while (sucessor->esquerda) sucessor = sucessor->esquerda.get();
-                node->carta = sucessor->carta;
-                node->direita = removerAVL(move(node->direita), sucessor->carta->id);
+                node->entrada = sucessor->entrada;
+                node->direita = removerAVL(move(node->direita), sucessor->entrada->chave);
             }
         }
     
@@ -540,11 +1631,33 @@ public:
         }
         tabelaHash.clear();
         
-        raizAVL.reset();
+        if constexpr (Indices::ordenado) {
+            raizAVL.reset();
+        }
+        if constexpr (Indices::porRating) {
+            indiceRating.clear();
+        }
+        if constexpr (Indices::agregados) {
+            agregados.limpar();
+        }
+        sincronizacoes.clear();
+        if constexpr (Indices::camadas) {
+            if (camadas.ativo) {
+                lock_guard<mutex> trava(camadas.m);
+                camadas.arquivo.close();
+                camadas.arquivo.open(camadas.caminho, ios::in | ios::out | ios::binary | ios::trunc);
+                camadas.bytesResidentes = 0;
+                camadas.residentes = 0;
+                camadas.ponteiro = 0;
+                camadas.paginasVivas = 0;
+                camadas.paginasMortas = 0;
+            }
+        }
         
         tamanho = 0;
         capacidade = 100;
         tabelaHash.resize(capacidade);
+        recalcularBuckets();
         
         cout << "Todos os dados foram removidos de forma segura.\n";
     }
@@ -557,19 +1670,13 @@ public:
     void exibirEstatisticas() const {
         cout << "\n=== ESTATÍSTICAS AVANÇADAS ===\n";
         
-        int total = contarNosAVL();
+        int total = tamanho;
         cout << "Total de cartas: " << total << endl;
         cout << "Memória aproximada: " << (total * 128)/1024 << " KB\n";
         
-        int colisoes = 0;
-        int bucketMax = 0;
-        int bucketsVazios = 0;
-        
-        for (const auto& bucket : tabelaHash) {
-            if (bucket.empty()) bucketsVazios++;
-            if (bucket.size() > 1) colisoes += bucket.size() - 1;
-            if (bucket.size() > bucketMax) bucketMax = bucket.size();
-        }
+        int bucketsVazios = bucketsPorTamanho[0];
+        int colisoes = tamanho - (capacidade - bucketsVazios);
+        int bucketMax = maiorBucket;
         
         cout << "\n=== TABELA HASH ===\n";
         cout << "Capacidade: " << capacidade << endl;
@@ -580,13 +1687,121 @@ public:
              << (bucketsVazios*100.0f/capacidade) << "%)" << endl;
         cout << "Maior bucket: " << bucketMax << " elementos" << endl;
         
-        if (raizAVL) {
-            cout << "\n=== ÁRVORE AVL ===\n";
-            cout << "Altura da árvore: " << altura(raizAVL) << endl;
-            cout << "Altura teórica mínima: " << floor(log2(total)) + 1 << endl;
+        if constexpr (Indices::ordenado) {
+            if (raizAVL) {
+                cout << "\n=== ÁRVORE AVL ===\n";
+                cout << "Altura da árvore: " << altura(raizAVL) << endl;
+                cout << "Altura teórica mínima: " << floor(log2(total)) + 1 << endl;
+            }
+        }
+
+        if constexpr (Indices::camadas) {
+            if (camadas.ativo) {
+                lock_guard<mutex> trava(camadas.m);
+                long long acertos = camadas.acertos;
+                long long acessos = acertos + camadas.faltas;
+                cout << "\n=== MEMÓRIA EM CAMADAS ===\n";
+                cout << "Orçamento: " << camadas.orcamento / 1024 << " KB | Em uso: "
+                     << camadas.bytesResidentes / 1024 << " KB\n";
+                cout << "Cartas residentes: " << camadas.residentes << " de " << tamanho << endl;
+                cout << "Taxa de acerto: " << (acessos ? acertos * 100.0 / acessos : 0.0) << "% ("
+                     << acertos << " acertos, " << camadas.faltas << " faltas)\n";
+                cout << "Despejos: " << camadas.despejos << " | Gravações: " << camadas.gravacoes
+                     << " | Leituras em varredura: " << camadas.leiturasVarredura << endl;
+                cout << "Arquivo de páginas: " << camadas.paginasVivas << " vivas | "
+                     << camadas.paginasMortas << " mortas | " << camadas.compactacoes << " compactações\n";
+            }
+        }
+
+        if constexpr (Indices::agregados) {
+            exibirAgregados();
+        }
+    }
+
+    // Com bytes > 0, mantém as cartas residentes dentro do orçamento e despeja as
+    // demais no arquivo de páginas. Com 0, traz todas de volta e apaga o arquivo.
+    bool definirOrcamentoMemoria(size_t bytes, const string& caminho = "cartas.pag") {
+        if constexpr (!Indices::camadas) {
+            cerr << "Memória em camadas desativada nesta configuração.\n";
+            return false;
+        } else {
+            lock_guard<mutex> trava(camadas.m);
+            if (bytes == 0) {
+                if (!camadas.ativo) return true;
+                for (const auto& bucket : tabelaHash) {
+                    for (const auto& e : bucket) {
+                        if (!e.carta) e.carta = camadas.lerPagina(e.deslocamento);
+                        e.deslocamento = -1;
+                        e.referenciada = false;
+                    }
+                }
+                camadas.arquivo.close();
+                remove(camadas.caminho.c_str());
+                camadas.reiniciar();
+                return true;
+            }
+
+            if (!camadas.ativo) {
+                camadas.arquivo.open(caminho, ios::in | ios::out | ios::binary | ios::trunc);
+                if (!camadas.arquivo.is_open()) {
+                    cerr << "Erro ao criar arquivo de páginas: " << caminho << endl;
+                    return false;
+                }
+                camadas.caminho = caminho;
+                camadas.bytesResidentes = 0;
+                camadas.residentes = 0;
+                for (const auto& bucket : tabelaHash) {
+                    for (const auto& e : bucket) {
+                        camadas.bytesResidentes += EstadoCamadas::tamanhoEstimado(*e.carta);
+                        camadas.residentes++;
+                    }
+                }
+                camadas.ativo = true;
+            }
+            camadas.orcamento = bytes;
+            camadas.despejarExcedente(tabelaHash);
+            return true;
+        }
+    }
+
+    void exibirAgregados() const {
+        if constexpr (!Indices::agregados) {
+            cout << "\nAgregados desativados nesta configuração.\n";
+        } else {
+            const auto& a = agregados;
+
+            cout << "\n=== ATRIBUTOS ===\n";
+            if (a.total == 0) {
+                cout << "Nenhuma carta carregada.\n";
+                return;
+            }
+            cout << fixed << setprecision(2);
+            cout << "Poder: média " << a.mediaPoder() << " | mín " << *a.poderes.begin()
+                 << " | máx " << *a.poderes.rbegin() << endl;
+            cout << "Resistência: média " << a.mediaResistencia() << " | mín " << *a.resistencias.begin()
+                 << " | máx " << *a.resistencias.rbegin() << endl;
+            cout << "Rating: média " << a.mediaRating() << " | mín " << *a.ratings.begin()
+                 << " | máx " << *a.ratings.rbegin() << endl;
+
+            cout << "\n=== HISTOGRAMA DE RATING ===\n";
+            for (int i = 0; i < AgregadosCartas::FAIXAS_RATING; i++) {
+                int n = a.histogramaRating[i];
+                cout << "[" << setw(2) << i << ", " << setw(2) << i + 1 << (i + 1 == AgregadosCartas::FAIXAS_RATING ? "]" : ")")
+                     << " " << setw(7) << n << " " << string(n * 50 / a.total, '#') << endl;
+            }
+
+            cout << "\n=== CARTAS POR TIPO ===\n";
+            for (const auto& [tipo, n] : a.porTipo) {
+                cout << tipo << ": " << n << endl;
+            }
         }
     }
 
+    // AgregadosCartas, ou um tipo vazio se a configuração não mantém agregados.
+    const auto& obterAgregados() const {
+        return agregados;
+    }
+
     void carregarDaAPIMenu() {
         int opcao;
         cout << "\nQuantas cartas deseja importar?\n";
@@ -629,34 +1844,127 @@ public:
 
         arquivo << "id,nome,poder,resistencia,rating,tipos\n";
 
-        function<void(const unique_ptr<NodeAVL>&)> escreverCartas = 
-            [&](const unique_ptr<NodeAVL>& node) {
-                if (!node) return;
-                escreverCartas(node->esquerda);
-                
-                arquivo << node->carta->id << ","
-                        << node->carta->nome << ","
-                        << node->carta->poder << ","
-                        << node->carta->resistencia << ","
-                        << node->carta->rating << ",\"";
-                
-                for (size_t i = 0; i < node->carta->tipos.size(); ++i) {
-                    if (i != 0) arquivo << "|";
-                    arquivo << node->carta->tipos[i];
-                }
-                arquivo << "\"\n";
-                
-                escreverCartas(node->direita);
-            };
-
-        escreverCartas(raizAVL);
+        paraCadaCarta([&](const shared_ptr<const Carta>& carta) {
+            arquivo << carta->id << ","
+                    << carta->nome << ","
+                    << carta->poder << ","
+                    << carta->resistencia << ","
+                    << carta->rating << ",\"";
+            
+            for (size_t i = 0; i < carta->tipos.size(); ++i) {
+                if (i != 0) arquivo << "|";
+                arquivo << carta->tipos[i];
+            }
+            arquivo << "\"\n";
+        });
         arquivo.close();
         cout << "Cartas exportadas com sucesso para: " << caminhoArquivo << endl;
     }
 };
 
+// Executa consultas de forma assíncrona no pool. O gerenciador não deve ser
+// alterado enquanto houver consultas pendentes.
+template <class Gerenciador>
+class ExecutorConsultas {
+public:
+    ExecutorConsultas(const Gerenciador& g, PoolTrabalho& p) : gerenciador(g), pool(p) {}
+
+    future<shared_ptr<const Carta>> buscarPorId(string id) {
+        return pool.submeter([this, id] { return gerenciador.buscarPorId(id); });
+    }
+
+    future<vector<shared_ptr<const Carta>>> buscarPorNome(string nome) {
+        return pool.submeter([this, nome] { return gerenciador.buscarPorNomeParalelo(nome, pool); });
+    }
+
+    future<vector<shared_ptr<const Carta>>> buscarPorRating(float min, float max) {
+        return pool.submeter([this, min, max] { return gerenciador.buscarPorRatingParalelo(min, max, pool); });
+    }
+
+    template <class T>
+    T aguardar(future<T>& f) {
+        return pool.aguardar(f);
+    }
+
+private:
+    const Gerenciador& gerenciador;
+    PoolTrabalho& pool;
+};
+
+using GerenciadorMenu = GerenciadorCartas<ChaveTexto, HashPolinomial, less<string_view>,
+                                          ComCamadas<ComAgregados<HashOrdenado>>>;
+
+vector<shared_ptr<Carta>> lerCartasCSV(const string& caminho, int limite) {
+    vector<shared_ptr<Carta>> cartas;
+    ifstream arquivo(caminho);
+    if (!arquivo.is_open()) {
+        cerr << "Erro ao abrir arquivo: " << caminho << endl;
+        return cartas;
+    }
+
+    string linha;
+    getline(arquivo, linha);
+    while ((int)cartas.size() < limite && getline(arquivo, linha)) {
+        vector<string> campos = dividirCampos(linha);
+        if (campos.size() < 5) continue;
+        try {
+            cartas.push_back(cartaDeCampos(campos));
+        } catch (const exception&) {
+        }
+    }
+    return cartas;
+}
+
+template <class Gerenciador>
+void medirConfiguracao(const string& nome, const vector<shared_ptr<Carta>>& cartas, const vector<string>& ids) {
+    Gerenciador gerenciador;
+
+    auto inicio = chrono::high_resolution_clock::now();
+    for (const auto& c : cartas) {
+        gerenciador.adicionarCarta(c);
+    }
+    auto meio = chrono::high_resolution_clock::now();
+
+    size_t encontrados = 0;
+    for (const auto& id : ids) {
+        if (gerenciador.buscarPorId(id)) encontrados++;
+    }
+    auto fim = chrono::high_resolution_clock::now();
+
+    auto insercao = chrono::duration_cast<chrono::milliseconds>(meio - inicio);
+    auto busca = chrono::duration_cast<chrono::milliseconds>(fim - meio);
+    // Alinha pela quantidade de caracteres, não de bytes UTF-8.
+    int largura = count_if(nome.begin(), nome.end(), [](char c) { return (c & 0xC0) != 0x80; });
+    cout << nome << string(max(0, 42 - largura), ' ')
+         << " | Inserção: " << setw(6) << insercao.count() << "ms"
+         << " | Busca por ID: " << setw(6) << busca.count() << "ms"
+         << " | Encontradas: " << encontrados << "\n";
+}
+
+void compararConfiguracoes(const string& caminho, int limite) {
+    auto cartas = lerCartasCSV(caminho, limite);
+    cout << "\n=== Comparação de Configurações (" << cartas.size() << " cartas) ===\n";
+
+    vector<string> ids;
+    for (const auto& c : cartas) ids.push_back(c->id);
+    shuffle(ids.begin(), ids.end(), mt19937(42));
+
+    medirConfiguracao<GerenciadorCartas<>>("Texto + hash + AVL (padrão)", cartas, ids);
+    medirConfiguracao<GerenciadorCartas<ChaveTexto, HashPolinomial, less<string_view>, ComAgregados<HashOrdenado>>>(
+        "Texto + hash + AVL + agregados", cartas, ids);
+    medirConfiguracao<GerenciadorMenu>("Texto + AVL + agregados + camadas (menu)", cartas, ids);
+    medirConfiguracao<GerenciadorCartas<ChaveTexto, HashFNV1a, less<string_view>, SomenteHash>>(
+        "Texto + somente hash", cartas, ids);
+    medirConfiguracao<GerenciadorCartas<ChaveInteira, HashInteiro, less<uint64_t>, HashOrdenado>>(
+        "Inteiro + hash + AVL", cartas, ids);
+    medirConfiguracao<GerenciadorCartas<ChaveInteira, HashInteiro, less<uint64_t>, SomenteHash>>(
+        "Inteiro + somente hash", cartas, ids);
+}
+
 int main() {
-    GerenciadorCartas gerenciador;
+    GerenciadorMenu gerenciador;
+    PoolTrabalho pool;
+    ExecutorConsultas<GerenciadorMenu> executor(gerenciador, pool);
     int opcao;
     
     do {
@@ -678,13 +1986,19 @@ int main() {
         cout << "11. Destruir Árvore AVL\n";
         cout << "12. Exibir Estatísticas\n";
         cout << "13. Exportar cartas para CSV\n";
+        cout << "14. Buscar Vários IDs\n";
+        cout << "15. Comparar Configurações do Gerenciador\n";
+        cout << "16. Remover Carta\n";
+        cout << "17. Executar Lote de Consultas em Paralelo\n";
+        cout << "18. Sincronizar com Arquivo CSV\n";
+        cout << "19. Definir Orçamento de Memória\n";
         cout << "0. Sair\n";
         cout << "Escolha: ";
         
         while (true) {
             cin >> opcao;
-            if (opcao >= 0 && opcao <= 13) break;
-            cout << "Opção inválida. Digite um número entre 0 e 13: ";
+            if (opcao >= 0 && opcao <= 19) break;
+            cout << "Opção inválida. Digite um número entre 0 e 19: ";
             cin.clear();
             cin.ignore(numeric_limits<streamsize>::max(), '\n');
         }
@@ -752,7 +2066,7 @@ int main() {
                 break;
             }
             case 9: {
-                int total = gerenciador.contarNosAVL();
+                int total = gerenciador.quantidadeCartas();
                 cout << "\nTotal de cartas na estrutura: " << total << endl;
                 if (total == 10000) {
                     cout << "✓ Todos os 10.000 registros foram carregados!\n";
@@ -776,6 +2090,111 @@ int main() {
                 gerenciador.exportarParaCSV();
                 break;
             }
+            case 14: {
+                string linha;
+                cout << "\n--- Busca por Vários IDs ---\nDigite os IDs separados por espaço ou vírgula: ";
+                getline(cin, linha);
+                replace(linha.begin(), linha.end(), ',', ' ');
+
+                vector<string> ids;
+                stringstream ss(linha);
+                string id;
+                while (ss >> id) ids.push_back(id);
+                vector<string_view> chaves(ids.begin(), ids.end());
+
+                vector<GerenciadorMenu::ReferenciaLote> cartas;
+                auto inicio = chrono::high_resolution_clock::now();
+                size_t encontrados = gerenciador.buscarPorIds(chaves, cartas);
+                auto fim = chrono::high_resolution_clock::now();
+
+                for (size_t i = 0; i < cartas.size(); i++) {
+                    if (cartas[i]) {
+                        cout << "ID: " << cartas[i]->id << " | Nome: " << cartas[i]->nome
+                             << " | Poder: " << cartas[i]->poder << " | Rating: " << cartas[i]->rating << "\n";
+                    } else {
+                        cout << "ID: " << ids[i] << " | não encontrada\n";
+                    }
+                }
+                auto duracao = chrono::duration_cast<chrono::microseconds>(fim - inicio);
+                cout << "Encontradas " << encontrados << " de " << ids.size()
+                     << " cartas em " << duracao.count() << "us\n";
+                break;
+            }
+            case 15: {
+                int limite = gerenciador.lerInteiro("\n--- Comparar Configurações ---\nQuantidade de cartas do CSV: ");
+                compararConfiguracoes("./pokemons.csv", limite);
+                break;
+            }
+            case 16: {
+                string id;
+                cout << "\n--- Remover Carta ---\nDigite o ID: ";
+                getline(cin, id);
+                if (gerenciador.removerCarta(id)) {
+                    cout << "Carta " << id << " removida.\n";
+                } else {
+                    cout << "Carta não encontrada.\n";
+                }
+                break;
+            }
+            case 17: {
+                string nome;
+                cout << "\n--- Lote de Consultas em Paralelo ---\nNome (ou parte): ";
+                getline(cin, nome);
+                float min = gerenciador.lerFloat("Rating mínimo: ");
+                float max = gerenciador.lerFloat("Rating máximo: ");
+
+                auto inicio = chrono::high_resolution_clock::now();
+                size_t nomeSeq = gerenciador.buscarPorNome(nome).size();
+                size_t ratingSeq = gerenciador.buscarPorRating(min, max).size();
+                size_t ratingAltoSeq = gerenciador.buscarPorRating(max, 10).size();
+                auto meio = chrono::high_resolution_clock::now();
+
+                auto porNome = executor.buscarPorNome(nome);
+                auto porRating = executor.buscarPorRating(min, max);
+                auto porRatingAlto = executor.buscarPorRating(max, 10);
+                size_t nomePar = porNome.get().size();
+                size_t ratingPar = porRating.get().size();
+                size_t ratingAltoPar = porRatingAlto.get().size();
+                auto fim = chrono::high_resolution_clock::now();
+
+                auto sequencial = chrono::duration_cast<chrono::milliseconds>(meio - inicio);
+                auto paralelo = chrono::duration_cast<chrono::milliseconds>(fim - meio);
+                cout << "Resultados: nome " << nomePar << " | rating " << ratingPar
+                     << " | rating >= " << max << " " << ratingAltoPar << "\n";
+                if (nomePar != nomeSeq || ratingPar != ratingSeq || ratingAltoPar != ratingAltoSeq) {
+                    cerr << "Aviso: resultados paralelos diferem dos sequenciais.\n";
+                }
+                cout << "Sequencial: " << sequencial.count() << "ms | Paralelo ("
+                     << pool.quantidadeThreads() << " threads): " << paralelo.count() << "ms\n";
+                break;
+            }
+            case 18: {
+                string caminho;
+                cout << "\n--- Sincronizar CSV ---\nCaminho do arquivo (Enter para ./pokemons.csv): ";
+                getline(cin, caminho);
+                if (caminho.empty()) caminho = "./pokemons.csv";
+
+                auto inicio = chrono::high_resolution_clock::now();
+                gerenciador.sincronizarCSV(caminho);
+                auto fim = chrono::high_resolution_clock::now();
+
+                auto duracao = chrono::duration_cast<chrono::milliseconds>(fim - inicio);
+                cout << "Tempo de sincronização: " << duracao.count() << "ms\n";
+                break;
+            }
+            case 19: {
+                int kb = gerenciador.lerInteiro("\n--- Orçamento de Memória ---\nOrçamento em KB (0 para manter tudo em memória): ");
+                if (kb < 0) {
+                    cout << "Orçamento inválido.\n";
+                } else if (gerenciador.definirOrcamentoMemoria(static_cast<size_t>(kb) * 1024, "./cartas.pag")) {
+                    if (kb == 0) {
+                        cout << "Todas as cartas estão em memória.\n";
+                    } else {
+                        cout << "Cartas frias serão despejadas em ./cartas.pag.\n";
+                    }
+                }
+                break;
+            }
             case 0: {
                 cout << "Encerrando o programa...\n";
                 break;